@@ -0,0 +1,42 @@
+/**
+ * @file reactor.cpp
+ * @brief multi_socket API using uc::curl::reactor (epoll + timerfd)
+ * @copyright Copyright (c) 2021, Kentaro Ushiyama
+ *
+ * Downloads every URL given on the command line in parallel.
+ * Unlike multi-uv.cpp, no event library and no glue code is needed.
+ */
+#include <iostream>
+#include <fstream>
+#include <vector>
+#include <memory>
+#include "../uccurl.h"
+
+int main(int argc, char **argv)
+{
+    if (argc <= 1) return 0;
+    try {
+        uc::curl::global libcurlInit;
+        uc::curl::reactor reactor;
+
+        std::vector<uc::curl::easy> handles;
+        std::vector<std::unique_ptr<std::ofstream>> files;
+        for (int i = 1; i < argc; ++i) {
+            const auto filename = std::to_string(i).append(".download");
+            files.emplace_back(new std::ofstream(filename, std::ios::out | std::ios::binary));
+            handles.push_back(uc::curl::easy(argv[i]).response(*files.back()));
+            reactor.add(handles.back());
+            std::cerr << "Added download " << argv[i] << " -> " << filename << "\n";
+        }
+
+        reactor.run([&](uc::curl::easy_ref h, CURLcode result) {
+            std::cout << h.uri() << " DONE (" << result << ")\n";
+            reactor.remove(h);
+        });
+
+    } catch (std::exception& ex) {
+        std::cerr << "exception : " << ex.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}